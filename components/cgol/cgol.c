@@ -51,16 +51,21 @@ struct cgol_s {
   uint8_t* internal_storage;
 };
 
+/* A slot with width == 0 is free */
 struct cgol_s games[CGOL_MAX_GAMES];
-int games_alloced = 0;
 
 static cgol_t init(int width, int height, uint8_t* static_storage) {
   if(width <= 0) return NULL;
   if(height <= 0) return NULL;
-  if(games_alloced >= CGOL_MAX_GAMES) return NULL;
 
-  cgol_t ctx = games + games_alloced;
-  ++games_alloced;
+  cgol_t ctx = NULL;
+  for(int i = 0; i < CGOL_MAX_GAMES; ++i) {
+    if(games[i].width == 0) {
+      ctx = games + i;
+      break;
+    }
+  }
+  if(!ctx) return NULL;
 
   int num_pages = height >> 3;
   int page_partial = height & 0x7;
@@ -135,7 +140,7 @@ void cgol_take_turn(cgol_t ctx) {
   memcpy(ctx->temp, ctx->state, ctx->num_pages * ctx->width);
   uint8_t* page = ctx->temp;
   uint8_t* page_up = NULL;
-  uint8_t* page_down = page + ctx->width;
+  uint8_t* page_down = ctx->num_pages > 1 ? page + ctx->width : NULL;
   uint8_t* new_page = ctx->state;
   uint8_t mask = 0x1;
   int page_index = 0;
@@ -171,5 +176,6 @@ uint8_t* cgol_get_state(cgol_t ctx) {
 void cgol_free(cgol_t* ctx) {
   if(*ctx == NULL) return;
   free((*ctx)->internal_storage);
+  memset(*ctx, 0, sizeof(struct cgol_s));
   *ctx = NULL;
 }
@@ -57,7 +57,7 @@ uint8_t* cgol_get_state(cgol_t ctx);
 /* Perform a game turn */
 void cgol_take_turn(cgol_t ctx);
 
-/* Free any allocated memory and set ctx = NULL */
+/* Free any allocated memory, release the game slot and set ctx = NULL */
 void cgol_free(cgol_t* ctx);
 
 #endif /* COMPONENTS_CGOL_H_ */
@@ -0,0 +1,222 @@
+/*
+ * Throughput benchmark for cgol_take_turn
+ *
+ * Runs a matrix of board sizes through cgol_take_turn and the frozen reference
+ * kernel. The two are timed in alternating slices of turns, so both see the
+ * same machine load. Each size is scored as the median over BENCH_RUNS runs of
+ * cgol_take_turn throughput divided by reference throughput. The score does
+ * not depend on the speed of the host.
+ *
+ * Usage:
+ *   bench_cgol                 print the matrix
+ *   bench_cgol --record        print the matrix in baseline file format
+ *   bench_cgol <baseline>      fail if a score is lower than the baseline by
+ *                              more than CGOL_BENCH_TOLERANCE (a fraction,
+ *                              default 0.25), or a size has no baseline
+ *
+ *  Copyright 2017 Sam Leitch
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include "cgol.h"
+#include "cgol_ref.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define ARRAY_SIZE(a) ((int)(sizeof(a) / sizeof((a)[0])))
+
+#define BENCH_RUNS 15
+#define BENCH_SLICES 8
+#define BENCH_MIN_CELLS 4000000.0
+
+static const int sizes[][2] = {
+  { 128, 64 },
+  { 128, 32 },
+  { 64, 48 },
+  { 127, 63 },
+  { 33, 17 },
+  { 256, 128 },
+};
+
+struct score_s {
+  double rate;
+  double reference_rate;
+  double ratio;
+};
+
+static double now_us(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+static void fill_random(uint8_t* state, int size) {
+  uint32_t x = 0x2017;
+  for(int i = 0; i < size; ++i) {
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    state[i] = (uint8_t)x;
+  }
+}
+
+static int compare_double(const void* a, const void* b) {
+  double da = *(const double*)a;
+  double db = *(const double*)b;
+  return (da > db) - (da < db);
+}
+
+static double median(double* values, int count) {
+  qsort(values, count, sizeof(double), compare_double);
+  if(count & 0x1) return values[count / 2];
+  return (values[count / 2 - 1] + values[count / 2]) / 2;
+}
+
+/* Median cells per microsecond of each kernel, and median of their per-run ratio */
+static struct score_s bench_size(int width, int height) {
+  int size = width * ((height + 7) >> 3);
+  int turns = (int)(BENCH_MIN_CELLS / (BENCH_SLICES * width * height)) + 1;
+  double cells = (double)width * height * turns * BENCH_SLICES;
+
+  cgol_t ctx = cgol_init(width, height);
+  if(!ctx) {
+    fprintf(stderr, "cgol_init(%d, %d) failed\n", width, height);
+    exit(EXIT_FAILURE);
+  }
+  uint8_t* state = cgol_get_state(ctx);
+  uint8_t* reference_state = (uint8_t*)malloc(size);
+  uint8_t* reference_temp = (uint8_t*)malloc(size);
+
+  double rates[BENCH_RUNS];
+  double reference_rates[BENCH_RUNS];
+  double ratios[BENCH_RUNS];
+  for(int run = 0; run < BENCH_RUNS; ++run) {
+    fill_random(state, size);
+    fill_random(reference_state, size);
+
+    double elapsed = 0;
+    double reference_elapsed = 0;
+    for(int slice = 0; slice < BENCH_SLICES; ++slice) {
+      /* Alternate which kernel goes first so neither always runs on a warm cache */
+      for(int half = 0; half < 2; ++half) {
+        bool reference = (slice + half) & 0x1;
+        double start = now_us();
+        for(int i = 0; i < turns; ++i) {
+          if(reference) {
+            cgol_ref_take_turn(width, height, reference_state, reference_temp);
+          } else {
+            cgol_take_turn(ctx);
+          }
+        }
+        double slice_elapsed = now_us() - start;
+        if(reference) {
+          reference_elapsed += slice_elapsed;
+        } else {
+          elapsed += slice_elapsed;
+        }
+      }
+    }
+
+    rates[run] = cells / elapsed;
+    reference_rates[run] = cells / reference_elapsed;
+    ratios[run] = reference_elapsed / elapsed;
+  }
+
+  struct score_s score;
+  score.rate = median(rates, BENCH_RUNS);
+  score.reference_rate = median(reference_rates, BENCH_RUNS);
+  score.ratio = median(ratios, BENCH_RUNS);
+
+  free(reference_state);
+  free(reference_temp);
+  cgol_free(&ctx);
+  return score;
+}
+
+static bool find_baseline(FILE* file, int width, int height, double* rate) {
+  char line[128];
+  rewind(file);
+  while(fgets(line, sizeof(line), file)) {
+    int w, h;
+    double r;
+    if(line[0] == '#') continue;
+    if(sscanf(line, "%d %d %lf", &w, &h, &r) != 3) continue;
+    if(w == width && h == height) {
+      *rate = r;
+      return true;
+    }
+  }
+  return false;
+}
+
+int main(int argc, char** argv) {
+  bool record = argc > 1 && strcmp(argv[1], "--record") == 0;
+  FILE* baseline = NULL;
+  if(argc > 1 && !record) {
+    baseline = fopen(argv[1], "r");
+    if(!baseline) {
+      fprintf(stderr, "cannot open baseline %s\n", argv[1]);
+      return EXIT_FAILURE;
+    }
+  }
+
+  double tolerance = 0.25;
+  const char* tolerance_env = getenv("CGOL_BENCH_TOLERANCE");
+  if(tolerance_env) tolerance = atof(tolerance_env);
+
+  if(record) {
+    printf("# width height ratio of cgol_take_turn to reference throughput, from bench_cgol --record\n");
+  } else {
+    printf("%9s %12s %12s %8s %8s\n", "size", "cells/us", "reference", "ratio", "baseline");
+  }
+
+  int failures = 0;
+  for(int i = 0; i < ARRAY_SIZE(sizes); ++i) {
+    int width = sizes[i][0];
+    int height = sizes[i][1];
+    struct score_s score = bench_size(width, height);
+
+    if(record) {
+      printf("%d %d %.3f\n", width, height, score.ratio);
+      continue;
+    }
+
+    printf("%4dx%-4d %12.2f %12.2f %8.3f", width, height, score.rate, score.reference_rate, score.ratio);
+
+    double expected;
+    if(!baseline) {
+      printf("\n");
+    } else if(find_baseline(baseline, width, height, &expected)) {
+      bool regressed = score.ratio < expected * (1.0 - tolerance);
+      if(regressed) ++failures;
+      printf(" %8.3f%s\n", expected, regressed ? "  REGRESSION" : "");
+    } else {
+      ++failures;
+      printf(" %8s  NO BASELINE\n", "-");
+    }
+  }
+
+  if(baseline) {
+    fclose(baseline);
+    printf("%d failures (tolerance %.0f%%)\n", failures, tolerance * 100);
+  }
+  return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,109 @@
+/*
+ * Frozen reference copy of the Game of Life kernel
+ *
+ * apply_rules, get_3_bits and cgol_take_turn copied verbatim from cgol.c,
+ * renamed, and with the context built from plain arguments.
+ * Do not optimise or otherwise edit this file.
+ *
+ *  Copyright 2017 Sam Leitch
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "cgol_ref.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+struct ref_ctx_s {
+  int width;
+  int height;
+  int num_pages;
+  uint8_t* state;
+  uint8_t* temp;
+};
+
+static bool ref_apply_rules(uint8_t left_3_bits, uint8_t middle_3_bits, uint8_t right_3_bits) {
+  bool is_living = (middle_3_bits & 0x2) > 0;
+
+  int neighbors = 0;
+  while(left_3_bits) {
+    if(left_3_bits & 0x1) ++neighbors;
+    left_3_bits >>= 1;
+  }
+
+  if(middle_3_bits & 0x1) ++neighbors;
+  if(middle_3_bits & 0x4) ++neighbors;
+
+  while(right_3_bits) {
+    if(right_3_bits & 0x1) ++neighbors;
+    right_3_bits >>= 1;
+  }
+
+  bool result = is_living;
+  if(is_living && (neighbors < 2)) result = false; // under-population
+  if(is_living && (neighbors > 3)) result = false; // over-population
+  if(!is_living && (neighbors == 3)) result = true; // procreation
+  return result;
+}
+
+static int ref_get_3_bits(uint8_t* page, uint8_t* page_up, uint8_t* page_down, int x, int y) {
+  int bit_offset = y & 0x7;
+  uint8_t byte = page[x];
+  if(bit_offset == 0) {
+    uint8_t prev_byte = page_up ? page_up[x] : 0;
+    return ((byte << 1) & 0x6) | ((prev_byte >> 7) & 0x1);
+  } else if(bit_offset == 7) {
+    uint8_t next_byte = page_down ? page_down[x] : 0;
+    return ((byte >> 6) & 0x03) | ((next_byte << 2) & 0x4);
+  } else {
+    return (byte >> (bit_offset - 1)) & 0x7;
+  }
+}
+
+void cgol_ref_take_turn(int width, int height, uint8_t* state, uint8_t* temp) {
+  struct ref_ctx_s ref_ctx = { width, height, (height + 7) >> 3, state, temp };
+  struct ref_ctx_s* ctx = &ref_ctx;
+
+  memcpy(ctx->temp, ctx->state, ctx->num_pages * ctx->width);
+  uint8_t* page = ctx->temp;
+  uint8_t* page_up = NULL;
+  uint8_t* page_down = ctx->num_pages > 1 ? page + ctx->width : NULL;
+  uint8_t* new_page = ctx->state;
+  uint8_t mask = 0x1;
+  int page_index = 0;
+  for(int y=0; y < ctx->height; ++y) {
+    for(int x = 0; x < ctx->width; ++x) {
+      uint8_t left_3_bits = x > 0 ? ref_get_3_bits(page, page_up, page_down, x-1, y) : 0;
+      uint8_t middle_3_bits = ref_get_3_bits(page, page_up, page_down, x, y);
+      uint8_t right_3_bits = x < (ctx->width - 1) ? ref_get_3_bits(page, page_up, page_down, x+1, y) : 0;
+
+      if(ref_apply_rules(left_3_bits, middle_3_bits, right_3_bits)) {
+        new_page[x] |= mask;
+      } else {
+        new_page[x] &= ~mask;
+      }
+    }
+
+    mask <<= 1;
+    if(mask == 0) {
+      mask = 0x1;
+      ++page_index;
+      page += ctx->width;
+      page_up = page - ctx->width;
+      page_down = page_index < (ctx->num_pages - 1) ? page + ctx->width : NULL;
+      new_page += ctx->width;
+    }
+  }
+}
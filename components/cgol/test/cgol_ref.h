@@ -0,0 +1,33 @@
+/*
+ * Frozen reference copy of the Game of Life kernel
+ *
+ * Every optimised kernel must match this bit for bit, including the bits of a
+ * partial last page that lie below the board and are never written.
+ *
+ *  Copyright 2017 Sam Leitch
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#ifndef COMPONENTS_CGOL_TEST_CGOL_REF_H_
+#define COMPONENTS_CGOL_TEST_CGOL_REF_H_
+
+#include <stdint.h>
+
+/*
+ * Perform a game turn on state, using temp as scratch space.
+ * Both buffers must hold width*ceil(height/8) bytes.
+ */
+void cgol_ref_take_turn(int width, int height, uint8_t* state, uint8_t* temp);
+
+#endif /* COMPONENTS_CGOL_TEST_CGOL_REF_H_ */
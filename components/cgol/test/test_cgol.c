@@ -0,0 +1,295 @@
+/*
+ * Differential test of cgol_take_turn against the frozen reference kernel
+ *
+ * Every case fills the whole state buffer, including the bits of a partial
+ * last page that lie below the board, then runs both kernels side by side and
+ * compares the full buffer after every generation.
+ *
+ * Boards are allocated with cgol_init so that, built with -fsanitize=address,
+ * any read past the end of the state or temp buffers is reported.
+ *
+ * Usage: test_cgol [seed]
+ *
+ *  Copyright 2017 Sam Leitch
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "cgol.h"
+#include "cgol_ref.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define ARRAY_SIZE(a) ((int)(sizeof(a) / sizeof((a)[0])))
+
+typedef void (*fill_fn)(uint8_t* state, int width, int height);
+
+static uint32_t rng_state;
+
+static uint32_t rng_next(void) {
+  uint32_t x = rng_state;
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  rng_state = x;
+  return x;
+}
+
+static int size_bytes(int width, int height) {
+  return width * ((height + 7) >> 3);
+}
+
+static void set_cell(uint8_t* state, int width, int x, int y) {
+  state[(y >> 3) * width + x] |= 1 << (y & 0x7);
+}
+
+static void fill_random(uint8_t* state, int width, int height, uint32_t density) {
+  int size = size_bytes(width, height);
+  for(int i = 0; i < size; ++i) {
+    uint8_t byte = 0;
+    for(int bit = 0; bit < 8; ++bit) {
+      if((rng_next() & 0xff) < density) byte |= 1 << bit;
+    }
+    state[i] = byte;
+  }
+}
+
+static void fill_sparse(uint8_t* state, int width, int height) {
+  fill_random(state, width, height, 32);
+}
+
+static void fill_half(uint8_t* state, int width, int height) {
+  fill_random(state, width, height, 128);
+}
+
+static void fill_dense(uint8_t* state, int width, int height) {
+  fill_random(state, width, height, 224);
+}
+
+static void fill_empty(uint8_t* state, int width, int height) {
+  memset(state, 0, size_bytes(width, height));
+}
+
+static void fill_full(uint8_t* state, int width, int height) {
+  memset(state, 0xff, size_bytes(width, height));
+}
+
+static void fill_border(uint8_t* state, int width, int height) {
+  fill_empty(state, width, height);
+  for(int x = 0; x < width; ++x) {
+    set_cell(state, width, x, 0);
+    set_cell(state, width, x, height - 1);
+  }
+  for(int y = 0; y < height; ++y) {
+    set_cell(state, width, 0, y);
+    set_cell(state, width, width - 1, y);
+  }
+}
+
+static void fill_checkerboard(uint8_t* state, int width, int height) {
+  fill_empty(state, width, height);
+  for(int y = 0; y < height; ++y) {
+    for(int x = 0; x < width; ++x) {
+      if((x + y) & 0x1) set_cell(state, width, x, y);
+    }
+  }
+}
+
+/* Rows either side of every page boundary plus the bottom row */
+static void fill_page_edges(uint8_t* state, int width, int height) {
+  fill_empty(state, width, height);
+  for(int y = 0; y < height; ++y) {
+    int bit_offset = y & 0x7;
+    if(bit_offset != 0 && bit_offset != 7 && y != height - 1) continue;
+    for(int x = 0; x < width; ++x) set_cell(state, width, x, y);
+  }
+}
+
+/* A glider flush against each corner, heading into it */
+static void fill_corners(uint8_t* state, int width, int height) {
+  static const int glider[][2] = { { 1, 0 }, { 2, 1 }, { 0, 2 }, { 1, 2 }, { 2, 2 } };
+  fill_empty(state, width, height);
+  for(int corner = 0; corner < 4; ++corner) {
+    for(int i = 0; i < ARRAY_SIZE(glider); ++i) {
+      int x = (corner & 0x1) ? width - 3 + glider[i][0] : 2 - glider[i][0];
+      int y = (corner & 0x2) ? height - 3 + glider[i][1] : 2 - glider[i][1];
+      if(x >= 0 && x < width && y >= 0 && y < height) set_cell(state, width, x, y);
+    }
+  }
+}
+
+/* Empty board, only the padding bits below a partial last page are set */
+static void fill_padding(uint8_t* state, int width, int height) {
+  fill_empty(state, width, height);
+  int page_partial = height & 0x7;
+  if(!page_partial) return;
+  uint8_t* last_page = state + (height >> 3) * width;
+  for(int x = 0; x < width; ++x) last_page[x] = (uint8_t)(0xff << page_partial);
+}
+
+struct pattern_s {
+  const char* name;
+  fill_fn fill;
+};
+
+static const struct pattern_s patterns[] = {
+  { "sparse", fill_sparse },
+  { "half", fill_half },
+  { "dense", fill_dense },
+  { "empty", fill_empty },
+  { "full", fill_full },
+  { "border", fill_border },
+  { "checkerboard", fill_checkerboard },
+  { "page_edges", fill_page_edges },
+  { "corners", fill_corners },
+  { "padding", fill_padding },
+};
+
+static const int widths[] = { 1, 2, 3, 5, 7, 8, 9, 31, 33, 127, 128, 129 };
+static const int heights[] = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 15, 16, 17, 31, 33, 63, 64, 65 };
+
+static int cases_run = 0;
+
+static bool compare(const uint8_t* state, const uint8_t* expected, int width, int height,
+    const char* name, int generation) {
+  int size = size_bytes(width, height);
+  if(memcmp(state, expected, size) == 0) return true;
+
+  for(int i = 0; i < size; ++i) {
+    uint8_t diff = state[i] ^ expected[i];
+    if(!diff) continue;
+    int bit = 0;
+    while(!(diff & (1 << bit))) ++bit;
+    int x = i % width;
+    int y = (i / width) * 8 + bit;
+    fprintf(stderr, "FAIL %s %dx%d: generation %d differs at x=%d y=%d%s (got 0x%02x, expected 0x%02x)\n",
+        name, width, height, generation, x, y, y >= height ? " (padding)" : "",
+        state[i], expected[i]);
+    break;
+  }
+  return false;
+}
+
+static bool run_case(const char* name, int width, int height, fill_fn fill, int generations,
+    uint8_t* static_storage) {
+  ++cases_run;
+  int size = size_bytes(width, height);
+
+  cgol_t ctx = static_storage ? cgol_init_static(width, height, static_storage)
+                              : cgol_init(width, height);
+  if(!ctx) {
+    fprintf(stderr, "FAIL %s %dx%d: cgol_init returned NULL\n", name, width, height);
+    return false;
+  }
+
+  uint8_t* expected = (uint8_t*)malloc(size);
+  uint8_t* expected_temp = (uint8_t*)malloc(size);
+  uint8_t* state = cgol_get_state(ctx);
+
+  fill(state, width, height);
+  memcpy(expected, state, size);
+
+  bool ok = true;
+  for(int generation = 1; ok && generation <= generations; ++generation) {
+    cgol_take_turn(ctx);
+    cgol_ref_take_turn(width, height, expected, expected_temp);
+    ok = compare(state, expected, width, height, name, generation);
+  }
+
+  free(expected);
+  free(expected_temp);
+  cgol_free(&ctx);
+  return ok;
+}
+
+/* Every pattern at every size for a few generations */
+static int test_matrix(void) {
+  int failures = 0;
+  for(int w = 0; w < ARRAY_SIZE(widths); ++w) {
+    for(int h = 0; h < ARRAY_SIZE(heights); ++h) {
+      for(int p = 0; p < ARRAY_SIZE(patterns); ++p) {
+        if(!run_case(patterns[p].name, widths[w], heights[h], patterns[p].fill, 4, NULL)) ++failures;
+      }
+    }
+  }
+  return failures;
+}
+
+/* Single page boards, where the bottom row has no page below it */
+static int test_single_page(void) {
+  int failures = 0;
+  for(int height = 1; height <= 8; ++height) {
+    for(int width = 1; width <= 16; ++width) {
+      if(!run_case("single_page", width, height, fill_full, 2, NULL)) ++failures;
+      if(!run_case("single_page", width, height, fill_half, 8, NULL)) ++failures;
+    }
+  }
+  return failures;
+}
+
+/* Random odd sizes */
+static int test_random_sizes(void) {
+  int failures = 0;
+  for(int i = 0; i < 200; ++i) {
+    int width = 1 + rng_next() % 160;
+    int height = 1 + rng_next() % 80;
+    const struct pattern_s* pattern = patterns + rng_next() % ARRAY_SIZE(patterns);
+    if(!run_case(pattern->name, width, height, pattern->fill, 16, NULL)) ++failures;
+  }
+  return failures;
+}
+
+/* Long runs, long enough for most random soups to settle */
+static int test_long_runs(void) {
+  static const int sizes[][2] = { { 128, 64 }, { 65, 65 }, { 33, 17 }, { 127, 63 }, { 9, 9 } };
+  int failures = 0;
+  for(int i = 0; i < ARRAY_SIZE(sizes); ++i) {
+    if(!run_case("long_half", sizes[i][0], sizes[i][1], fill_half, 1000, NULL)) ++failures;
+    if(!run_case("long_sparse", sizes[i][0], sizes[i][1], fill_sparse, 1000, NULL)) ++failures;
+  }
+  return failures;
+}
+
+/* cgol_init_static with storage sized exactly as documented */
+static int test_static_storage(void) {
+  int failures = 0;
+  for(int h = 0; h < ARRAY_SIZE(heights); ++h) {
+    int width = 33;
+    int height = heights[h];
+    uint8_t* storage = (uint8_t*)malloc(2 * size_bytes(width, height));
+    if(!run_case("static", width, height, fill_half, 16, storage)) ++failures;
+    free(storage);
+  }
+  return failures;
+}
+
+int main(int argc, char** argv) {
+  uint32_t seed = argc > 1 ? (uint32_t)strtoul(argv[1], NULL, 0) : 0x2017;
+  if(seed == 0) seed = 1;
+  rng_state = seed;
+  printf("seed 0x%x\n", seed);
+
+  int failures = 0;
+  failures += test_matrix();
+  failures += test_single_page();
+  failures += test_random_sizes();
+  failures += test_long_runs();
+  failures += test_static_storage();
+
+  printf("%d cases, %d failures\n", cases_run, failures);
+  return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}